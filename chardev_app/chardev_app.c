@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>      // For error handling
+#include <limits.h>     // Defines PATH_MAX
 #include <unistd.h>     // Needed for ftruncate
 #include <fcntl.h>      // Defines O_* constants
 #include <sys/stat.h>   // Defines mode constants
@@ -31,6 +32,7 @@
 #include <signal.h>     // Needed for signal handling
 #include <pthread.h>    // Needed for multi-threading
 #include <gpiod.h>      // GPIO char. dev. API
+#include <dirent.h>     // Needed for finding I2C bus
 
 /** Includes needed for periodicity */
 #include <sys/time.h>
@@ -40,22 +42,86 @@
 #include <sys/epoll.h>
 /** Includes needed for proper I2C functionality */
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
+/** Name of the sensor bus adapter, i2c-dev numbering depends on probe order */
+#define I2C_BUS_NAME "custom_i2cctl"
+
 /** I2C parameters - address, registers and mask */
 #define CUSTOM_I2C_SENS_ADDR (27)
 #define I2C_CTRL_OFFSET                 (0x0)
 #define I2C_DATA_OFFSET                 (0x1)
+#define I2C_COUNT_OFFSET                (0x2)
+#define I2C_NUM_SAMPLES                 (8)
 #define I2C_CTRL_EN_MASK                (0x01)
 
+/** Name of the I2C sensor data-ready line, see gpio-line-names in DTS */
+#define I2C_DRDY_LINE "I2C_DRDY"
+
+/**
+ * Host GPIO bank the application uses. Bank 0 is the motherboard PL061,
+ * further banks (QEMU -global pl061.banks=N) follow at 0x10040000, one
+ * 4K page each. Chips are found by label, numbering depends on probe order.
+ */
+#define GPIO_BANK (0)
+#define GPIO_BANK0_ADDR (0x10003000)
+#define GPIO_BANKS_ADDR (0x10040000)
+#define GPIO_BANK_ADDR(bank) ((bank) ? GPIO_BANKS_ADDR + ((bank) - 1) * 0x1000 \
+                                     : GPIO_BANK0_ADDR)
+
+/**
+ * Edge timestamp registers of the QEMU PL061 model, 0x20 bytes per line,
+ * read through /dev/mem. Build with -DGPIO_LATENCY=1 to print how long each
+ * input event spent on the host, in the emulator and kernel, and in this
+ * application.
+ */
+#ifndef GPIO_LATENCY
+#define GPIO_LATENCY (0)
+#endif
+#define GPIO_TS_OFFSET (0x800)
+#define GPIO_TS_LINE_SIZE (0x20)
+#define GPIO_TS_NOW_OFFSET (0x900)
+
+/** MM sensor character device and the samples taken per read */
+#define MMS_DEV "/dev/custom_mms0"
+#define MMS_BATCH (64)
+
+/**
+ * Build with -DMMS_MMAP=1 to consume MM sensor samples in place from the
+ * ring the driver maps, instead of reading them.
+ */
+#ifndef MMS_MMAP
+#define MMS_MMAP (0)
+#endif
+
+/** Sample record returned by the MM sensor driver */
+struct mms_sample {
+    uint64_t stamp;     /* CLOCK_MONOTONIC time the driver took it, ns */
+    uint32_t seq;       /* Sample number, a gap means samples were dropped */
+    uint32_t sample;    /* Sample value */
+};
+
+/** Header of the MM sensor sample ring */
+struct mms_map {
+    uint32_t head;      /* Samples written by the driver */
+    uint32_t tail;      /* Samples consumed, written by us */
+    uint32_t entries;   /* Ring size, power of two */
+    uint32_t offset;    /* Offset of the first sample */
+    uint32_t dropped;   /* Samples dropped while the ring was full */
+};
+
 /** Name of the GPIO consumers */
 #define GPIOD_INPUT "gpiod-input"
 #define GPIOD_OUTPUT "gpiod-output"
+#define GPIOD_I2C_DRDY "gpiod-i2c-drdy"
 
 /** Number of GPIO pins which will be used */
 unsigned int pin_num = 8;
 /** Global pointer on GPIO chip */
 struct gpiod_chip *dev_chip;
+/** Registers of the GPIO bank, NULL unless latency is printed */
+volatile uint32_t *gpio_regs;
 
 /**
  * @brief Signal handler function
@@ -136,11 +202,160 @@ static void wait_period(struct periodic_info *info) {
 	info->wakeups_missed += missed;
 }
 
+/**
+ * @brief Read I2C samples
+ *
+ * Function reads sample count and all queued samples in one transaction and
+ * prints them, repeating while the sensor buffer comes back full.
+ *
+ */
+static void i2c_read_samples(int fd){
+	/* Buffer used for communication, count and 16-bit samples */
+    unsigned char buffer[1 + 2 * I2C_NUM_SAMPLES];
+	/* Aux. variables for storing data */
+	uint16_t data;
+	int count, i;
+
+	/* Register address write and read with a repeated start */
+	unsigned char reg = I2C_COUNT_OFFSET;
+	struct i2c_msg msgs[2] = {
+		{ .addr = CUSTOM_I2C_SENS_ADDR, .flags = 0, .len = 1, .buf = &reg },
+		{ .addr = CUSTOM_I2C_SENS_ADDR, .flags = I2C_M_RD, .len = sizeof(buffer), .buf = buffer },
+	};
+	struct i2c_rdwr_ioctl_data rdwr = { .msgs = msgs, .nmsgs = 2 };
+
+	do {
+		if (ioctl(fd, I2C_RDWR, &rdwr) < 0) {
+			printf("I2C transfer failed\n");
+			return;
+		}
+		
+		/* Nothing queued, first sample holds the current value */
+		count = buffer[0] ? buffer[0] : 1;
+		
+		for (i = 0; i < count; i++) {
+			/* Samples are big endian */
+			data = (buffer[1 + 2 * i] << 8) | buffer[2 + 2 * i];
+			
+			printf("I2C data = %d\n", data);
+		}
+	} while (buffer[0] == I2C_NUM_SAMPLES);
+}
+
+/**
+ * @brief Open I2C bus
+ *
+ * Function opens the i2c-dev node of the adapter with given name.
+ * Returns file descriptor, or -1 if there is no such adapter.
+ *
+ */
+static int i2c_bus_open(const char *name){
+    DIR *dir;
+    struct dirent *ent;
+    char path[PATH_MAX], adapter[64];
+    FILE *f;
+    int fd = -1;
+
+    dir = opendir("/sys/class/i2c-dev");
+    if (dir == NULL) {
+        return -1;
+    }
+
+    while (fd < 0 && (ent = readdir(dir)) != NULL) {
+        if (strncmp(ent->d_name, "i2c-", 4) != 0) {
+            continue;
+        }
+
+        /* Compare adapter name, without trailing new line */
+        snprintf(path, sizeof(path), "/sys/class/i2c-dev/%s/name", ent->d_name);
+        f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        if (fgets(adapter, sizeof(adapter), f) == NULL) {
+            adapter[0] = '\0';
+        }
+        fclose(f);
+        adapter[strcspn(adapter, "\n")] = '\0';
+        if (strcmp(adapter, name) != 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/dev/%s", ent->d_name);
+        fd = open(path, O_RDWR);
+    }
+
+    closedir(dir);
+    return fd;
+}
+
+/**
+ * @brief Map GPIO bank registers
+ *
+ * Function maps the register page of the GPIO bank through /dev/mem, for
+ * reading edge timestamps. Returns NULL if it can't be mapped.
+ *
+ */
+static volatile uint32_t *gpio_map_regs(void){
+    void *regs;
+    int fd;
+
+    fd = open("/dev/mem", O_RDONLY | O_SYNC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    regs = mmap(NULL, 0x1000, PROT_READ, MAP_SHARED, fd, GPIO_BANK_ADDR(GPIO_BANK));
+    close(fd);
+
+    return regs == MAP_FAILED ? NULL : regs;
+}
+
+/** Read a 64-bit timestamp register, its low word latches the high one */
+static uint64_t gpio_read_ts(unsigned int offset){
+    uint64_t lo = gpio_regs[offset / 4];
+
+    return lo | ((uint64_t)gpio_regs[offset / 4 + 1] << 32);
+}
+
+/**
+ * @brief Print input event latency
+ *
+ * Function splits the latency of an input event into the time it took the
+ * host to hand it to QEMU, the time from QEMU applying it to the kernel
+ * timestamp and the time until this application got it. Guest clocks run
+ * on QEMU virtual time, the offset between them is taken just now.
+ *
+ */
+static void gpio_print_latency(unsigned int line, const struct gpiod_line_event *ev){
+    unsigned int base = GPIO_TS_OFFSET + line * GPIO_TS_LINE_SIZE;
+    uint64_t virt, origin, arrival, now_virt, now, event;
+    struct timespec rt;
+
+    /* Reading the virtual time latches the other stamps of the line */
+    virt = gpio_read_ts(base);
+    origin = gpio_read_ts(base + 0x08);
+    arrival = gpio_read_ts(base + 0x10);
+
+    now_virt = gpio_read_ts(GPIO_TS_NOW_OFFSET);
+    /* Event timestamps are CLOCK_REALTIME on this kernel */
+    clock_gettime(CLOCK_REALTIME, &rt);
+    now = rt.tv_sec * 1000000000ULL + rt.tv_nsec;
+    event = ev->ts.tv_sec * 1000000000ULL + ev->ts.tv_nsec;
+
+    printf("GPIO line %u latency: host %lld us, emulator and kernel %lld us, "
+           "application %lld us\n", line,
+           origin ? (long long)(arrival - origin) / 1000 : -1LL,
+           (long long)(event - (now - now_virt) - virt) / 1000,
+           (long long)(now - event) / 1000);
+}
+
 /**
  * @brief I2C thread
  *
  * Function which represents I2C thread. It consists of opening, enabling and reading data
- * from I2C slave, after which result is constantly printed to display.
+ * from I2C slave whenever its data-ready line rises, after which result is printed to display.
+ * Without the data-ready line the slave is polled every second.
  *
  */
 void *i2c_handler(){
@@ -150,15 +365,16 @@ void *i2c_handler(){
     int fd;
 	/* Buffer used for communication */
     char buffer[4];
-	/* Aux. variables for storing data */
-	uint8_t data;
+	/* Data-ready line and its event */
+	struct gpiod_line *drdy;
+	struct gpiod_line_event ev;
     
     printf("I2C thread started\n");
 	
 	/* Open I2C and set slave address */
-	fd = open("/dev/i2c-2",O_RDWR);
+	fd = i2c_bus_open(I2C_BUS_NAME);
 	if (fd < 0){
-		printf("Can't open i2c-2\n");
+		printf("Can't open I2C bus %s\n", I2C_BUS_NAME);
 	}
 	if (ioctl(fd, I2C_SLAVE, CUSTOM_I2C_SENS_ADDR) < 0) { 
 		printf("Can't set I2C slave address\n");
@@ -169,45 +385,110 @@ void *i2c_handler(){
     buffer[1] = I2C_CTRL_EN_MASK;
     write(fd, buffer, 2) ;
 	
-	/* Enable timer */
-	make_periodic(1000000, &info);
+	/* Wait on data-ready line, fall back to timer without it */
+	drdy = gpiod_line_find(I2C_DRDY_LINE);
+	if (drdy && gpiod_line_request_rising_edge_events(drdy, GPIOD_I2C_DRDY) < 0){
+		gpiod_line_close_chip(drdy);
+		drdy = NULL;
+	}
+	if (!drdy){
+		printf("No I2C data-ready line, polling\n");
+		make_periodic(1000000, &info);
+	}
 
     while (1) {
-	    /* Wait for timer event */
-		wait_period(&info);
+		/* Read whatever is queued, also before the first wait */
+		i2c_read_samples(fd);
 		
-		/* Read from data register */
-		buffer[0] = I2C_DATA_OFFSET;
-		write(fd,buffer,1);
-		read(fd,buffer,1);
-		
-		/* Store in aux. var */
-		data = (int8_t)buffer[0];
-		
-		printf("I2C data = %d\n", data);
+		if (drdy){
+			/* Block until new samples raise data-ready */
+			if (gpiod_line_event_wait(drdy, NULL) == 1){
+				gpiod_line_event_read(drdy, &ev);
+			}
+		}
+		else{
+		    /* Wait for timer event */
+			wait_period(&info);
+		}
     }
 	
 	close(fd);
 }
 
+/**
+ * @brief Consume MM sensor ring
+ *
+ * Function maps the sample ring of the MM sensor and prints samples straight
+ * from it, poll() is only used to wait while the ring is empty.
+ *
+ */
+static void mms_consume_ring(int dev_fd){
+    /* Mapped ring header and samples */
+    struct mms_map *map;
+    struct mms_sample *samples;
+    /* Size of mapping */
+    size_t size;
+    /* Pool struct */
+    struct pollfd pfd;
+    uint32_t head, tail;
+    
+    /* Header tells the size of the ring */
+    map = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, dev_fd, 0);
+    if (map == MAP_FAILED) {
+        printf("Can't map %s\n", MMS_DEV);
+        return;
+    }
+    size = map->offset + map->entries * sizeof(struct mms_sample);
+    munmap(map, sysconf(_SC_PAGESIZE));
+    
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, dev_fd, 0);
+    if (map == MAP_FAILED) {
+        printf("Can't map %s\n", MMS_DEV);
+        return;
+    }
+    samples = (struct mms_sample *)((char *)map + map->offset);
+    
+    pfd.fd = dev_fd;
+    pfd.events = POLLIN;
+    
+    /* Start with samples taken from now on */
+    tail = __atomic_load_n(&map->head, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&map->tail, tail, __ATOMIC_RELEASE);
+    
+    while(1) {
+        head = __atomic_load_n(&map->head, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            poll(&pfd, 1, -1);
+            continue;
+        }
+        
+        while (tail != head) {
+            printf("MMS data = %u, ", samples[tail & (map->entries - 1)].sample);
+            tail++;
+        }
+        /* Entries may be reused once tail is past them */
+        __atomic_store_n(&map->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
 /**
  * @brief MM sensor thread
  *
  * Function which represents memory-mapped sensor thread. It consists of enabling sensor,
- * its' interrupts after which data is being read and printed on display.
+ * its' interrupts after which data is being read and printed on display. Samples are
+ * read from the character device in batches, as binary records.
  *
  */
 void *mms_handler(){
-    /* MM sensor sysfs file descriptor */
-    int sysfs_fd;
+    /* MM sensor sysfs and character device file descriptors */
+    int sysfs_fd, dev_fd;
     /* Aux. variable when doing read/write operations */
-    int ret;
-	/* Buffer needed for read and write */
+    ssize_t ret;
+	/* Buffer needed for write */
     char buffer[10] = {0};
-	/* Aux. variables for storing data */
-	uint8_t data;
-	/* Pool struct */
-	struct pollfd pfd;
+	/* Samples taken by one read */
+	struct mms_sample samples[MMS_BATCH];
+	int i;
     
     printf("MMS thread started!\n");
     
@@ -234,35 +515,36 @@ void *mms_handler(){
 	
 
 	/* Prepare for reading */
-	sysfs_fd = open("/sys/class/custom_mms/custom_mms0/data", O_RDONLY);
-	if (sysfs_fd < 0){
-        printf("Can't open data\n");
+	dev_fd = open(MMS_DEV, O_RDONLY);
+	if (dev_fd < 0){
+        printf("Can't open %s\n", MMS_DEV);
+        return NULL;
 	}
-
-    ret = read(sysfs_fd, buffer, sizeof(buffer));
-    lseek(sysfs_fd,0,SEEK_SET);
-
-	/* Prepare for pooling */
-	pfd.fd = sysfs_fd;
-	pfd.events = POLLPRI|POLLERR;
+    
+    if (MMS_MMAP) {
+        mms_consume_ring(dev_fd);
+        close(dev_fd);
+        return NULL;
+    }
     
     while(1) {
-        /* Pool */
-        ret = poll(&pfd, 1, -1);
-
-        if (ret > 0) {
-            /* Read from data register */
-            ret = read(sysfs_fd, buffer, sizeof(buffer));
-
-            /* Convert to integer and print */
-            data = atoi(buffer);
-            printf("MMS data = %d, ", data);
+        /* Blocks until at least one sample was taken */
+        ret = read(dev_fd, samples, sizeof(samples));
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("Can't read %s\n", MMS_DEV);
+            break;
+        }
 
-            /* Reset file descriptor pointer */
-            lseek(pfd.fd,0,SEEK_SET);
+        for (i = 0; i < ret / sizeof(samples[0]); i++) {
+            printf("MMS data = %u, ", samples[i].sample);
         }
     }
     
+    close(dev_fd);
+    return NULL;
 }
 
 /**
@@ -281,6 +563,8 @@ int main(){
     int pin_values[4] = {0};
     /* Aux. variable when doing read/write operations */
     int ret;
+    /* Label of the GPIO bank chip */
+    char label[32];
 	/* Pool thread */
     pthread_t i2c_thread, mms_thread;
     
@@ -304,7 +588,8 @@ int main(){
     /************************************************
      * Open GPIO chip
      ************************************************/
-    dev_chip = gpiod_chip_open("/dev/gpiochip4");
+    snprintf(label, sizeof(label), "%x.pl061", GPIO_BANK_ADDR(GPIO_BANK));
+    dev_chip = gpiod_chip_open_by_label(label);
     //if (dev_chip = NULL){
     /*if (!dev_chip){
         perror("Opening GPIO chip failed!");
@@ -312,6 +597,13 @@ int main(){
     }*/
     printf("Successfully opened chip!\n");
     
+    if (GPIO_LATENCY) {
+        gpio_regs = gpio_map_regs();
+        if (!gpio_regs) {
+            printf("Can't map GPIO registers, latency is not printed\n");
+        }
+    }
+    
     /************************************************
      * Get input bulk
      ************************************************/
@@ -395,6 +687,9 @@ int main(){
                 //printf("Line event offset is %d\n", line_offset);
                 
                 gpiod_line_event_read(event_line, &ev);
+                if (gpio_regs) {
+                    gpio_print_latency(line_offset, &ev);
+                }
                 if (ev.event_type == GPIOD_LINE_EVENT_RISING_EDGE) {
                     pin_values[line_offset] = 1;
                 }
@@ -13,21 +13,13 @@
 #include <QPainter>
 #include <QGradient>
 #include <QPaintDevice>
-#include <QTimer>
 #include <QDebug>
 
 #include <math.h>
 #include <cstddef> // for NULL
 #include "LED.h"
-
-/* Aditional includes from C library, needed for shared memory */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <unistd.h> /* ftruncate */
-#include <fcntl.h> /* Defines O_* constants */
-#include <sys/stat.h> /* Defines mode constants */
-#include <sys/mman.h> /* Defines mmap flags */
+#include "board_shm.h"
+#include "gpiowatcher.h"
 
 LED::LED(QWidget* parent) :
     QWidget(parent),
@@ -36,21 +28,16 @@ LED::LED(QWidget* parent) :
     alignment_(Qt::AlignCenter),
     state_(true),
     gpioPin_(0),
-    refreshRate_(100),
-    data_(NULL)
+    gpioBank_(0)
 {
     setDiameter(diameter_);
-    setRefreshRate(refreshRate_);
-
-    /* Map shared memory segment to appropriate variable */
-    mapToSharedMemory();
 
-    /* Instantiate timer, connect its' timeout signal to
-     * refresh slot function and start it
+    /* Follow GPIO data published by PL061, the watcher is shared by all
+     * LEDs and only reports lines which actually changed
      */
-    timer_ = new QTimer(this);
-    connect(timer_, SIGNAL(timeout()), this, SLOT(refreshGpio()));
-    timer_->start(refreshRate_);
+    connect(GpioWatcher::instance(), SIGNAL(changed(int,quint32,quint32)),
+            this, SLOT(gpioChanged(int,quint32,quint32)));
+    refreshGpio();
 }
 
 LED::~LED()
@@ -113,46 +100,58 @@ int LED::gpioPin() const
 
 void LED::setGpioPin(int gpioPin)
 {
+    /* Lines of a bank only, other values are ignored */
+    if (gpioPin < 0 || gpioPin >= BOARD_SHM_GPIO_LINES){
+        return;
+    }
+
     gpioPin_ = gpioPin;
+
+    refreshGpio();
 }
 
-int LED::
-refreshRate() const{
-    return refreshRate_;
+int LED::gpioBank() const
+{
+    return gpioBank_;
 }
 
-void LED::
-setRefreshRate(int rate)
+void LED::setGpioBank(int gpioBank)
 {
-    refreshRate_ = rate;
+    /* Banks of the board only, other values are ignored */
+    if (gpioBank < 0 || gpioBank >= BOARD_SHM_GPIO_BANKS){
+        return;
+    }
 
-    update();
+    gpioBank_ = gpioBank;
+
+    refreshGpio();
 }
 
 void LED::
 setState(bool state)
 {
+    /* Repaint only on a real change */
+    if (state_ == state){
+        return;
+    }
+
     state_ = state;
     update();
 }
 
 void LED::refreshGpio()
 {
-    /* Auxiliary variables */
-    unsigned int mask, bit, pin;
-
-    /* Determine mask value */
-    pin = gpioPin();
-    mask = 1 << pin;
+    /* Determine mask value and read the last published data */
+    unsigned int mask = 1u << gpioPin();
 
-    /* Get data bit value and toggle it */
-    bit = *data_ & mask;
+    setState(GpioWatcher::instance()->value(gpioBank()) & mask);
+}
 
-    if (bit){
-        setState(true);
-    }
-    else{
-        setState(false);
+void LED::gpioChanged(int bank, quint32 mask, quint32 value)
+{
+    /* Ignore changes of other banks and lines */
+    if (bank == gpioBank() && (mask & (1u << gpioPin()))){
+        setState(value & (1u << gpioPin()));
     }
 }
 
@@ -214,29 +213,3 @@ void LED::paintEvent(QPaintEvent *event)
     p.drawEllipse(x, y, diamX_-1, diamY_-1);
 
 }
-
-void LED::mapToSharedMemory()
-{
-    /* File descriptor and auxiliary variable for storing size of shared memory */
-    int fd, segSize;
-    segSize = sizeof(unsigned int);
-
-    /* Create new shared memory object */
-    fd = shm_open("gpio", O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
-    if (fd == -1){
-        qDebug() << "Function shm_open failed!\n";
-    }
-
-    /* Set sh. mem. segment size */
-    if (ftruncate(fd, segSize) == -1){
-        qDebug() << "Truncating shared memory failed!\n";
-    }
-
-    /* Map shared memory object to process virtual address space */
-    data_ = (unsigned int*)mmap(NULL, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data_ == MAP_FAILED) {
-        qDebug() << "Memory mapping failed!\n";
-    }
-
-    update();
-}
@@ -1,5 +1,6 @@
 #include "LED.h"
 #include "LEDPlugin.h"
+#include "gpiosource.h"
 
 #include <QtPlugin>
 
@@ -7,6 +8,8 @@ LEDPlugin::LEDPlugin(QObject* parent) :
 	QObject(parent),
 	initialized(false)
 {
+    /* Previews in Designer must not attach to a running board */
+    GpioSource::setBackend(GpioSource::Simulated);
 }
 
 
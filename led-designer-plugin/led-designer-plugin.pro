@@ -17,9 +17,9 @@ TARGET = $$qtLibraryTarget($$TARGET)
 target.path = $$[QT_INSTALL_PLUGINS]/designer
 INSTALLS += target
 
-INCLUDEPATH += .
+INCLUDEPATH += . ../qt-app
 
 # Input
-HEADERS += LED.h LEDPlugin.h
-SOURCES += LED.cpp LEDPlugin.cpp
+HEADERS += LED.h LEDPlugin.h ../qt-app/board_shm.h ../qt-app/gpiosource.h ../qt-app/gpiowatcher.h
+SOURCES += LED.cpp LEDPlugin.cpp ../qt-app/board_shm.cpp ../qt-app/gpiosource.cpp ../qt-app/gpiowatcher.cpp
 
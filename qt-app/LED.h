@@ -16,9 +16,6 @@
 #include <QtDesigner/QtDesigner>
 #include <QWidget>
 
-/* Needed for QTimer instance */
-class QTimer;
-
 /**
  * LED class
  */
@@ -52,31 +49,30 @@ class QDESIGNER_WIDGET_EXPORT LED : public QWidget
     Q_PROPERTY(bool state READ state WRITE setState)
 
     /**
-     * @brief GPIO pin
+     * @brief GPIO pin, 0 to BOARD_SHM_GPIO_LINES - 1
      * @accessors %gpioPin(), setGpioPin()
      */
     Q_PROPERTY(int gpioPin READ gpioPin WRITE setGpioPin)
 
     /**
-     * @brief Refresh rate for reading GPIO pin
-     * @accessors %refreshRate(), setRefreshRate()
+     * @brief GPIO bank of the pin, 0 to BOARD_SHM_GPIO_BANKS - 1
+     * @accessors %gpioBank(), setGpioBank()
      */
-    Q_PROPERTY(int refreshRate READ refreshRate WRITE setRefreshRate)
+    Q_PROPERTY(int gpioBank READ gpioBank WRITE setGpioBank)
 
 public:
     /**
      * @brief Constructor
      *
-     * Constructor initializes its' members, maps data to the
-     * shared memory, starts timer and makes preparations for
-     * refreshing read GPIO value
+     * Constructor initializes its' members and subscribes to
+     * GPIO data changes reported by the shared GPIO watcher
      */
     explicit LED(QWidget* parent=0);
 
     /**
      * @brief Destructor
      *
-     * Destructor unlinks shared memory
+     * Destructor leaves the shared GPIO watcher running for other LEDs
      */
     ~LED();
 
@@ -103,10 +99,10 @@ public:
     /** Method which sets the LED GPIO pin */
     void setGpioPin(int gpioPin);
 
-    /** Method returning the refresh rate */
-    int refreshRate() const;
-    /** Method which sets the refresh rate */
-    void setRefreshRate(int refreshRate);
+    /** Method returning the GPIO bank value */
+    int gpioBank() const;
+    /** Method which sets the LED GPIO bank */
+    void setGpioBank(int gpioBank);
 
 public slots:
     /** Slot function user for reading LED state */
@@ -115,6 +111,9 @@ public slots:
     /** Slot function used for reading the GPIO pin value */
     void refreshGpio();
 
+    /** Slot function called by the GPIO watcher when lines change */
+    void gpioChanged(int bank, quint32 mask, quint32 value);
+
 public:
     /** Method which returns the preferred height for the widget given the width */
     int heightForWidth(int width) const;
@@ -131,23 +130,18 @@ protected:
      */
     void paintEvent(QPaintEvent* event);
 
-    /** Mapping shared memory data to private data */
-    void mapToSharedMemory();
-
 private:
     double diameter_; /**< LED widget diameter */
     QColor color_; /**< LED widget color */
     Qt::Alignment alignment_; /**< LED widget aligment */
     bool state_; /**< LED state */
     int gpioPin_; /**< Appropriate GPIO pin value */
-    int refreshRate_; /**< Refresh rate of reading from GPIO */
-    unsigned int *data_; /**< Pointer to shared memory containing data */
+    int gpioBank_; /**< GPIO bank the pin belongs to */
 
     int pixX_, pixY_; /**< Pixels per mm for x and y */
     int diamX_, diamY_;  /**< Scaled values for x and y diameter */
 
     QRadialGradient gradient_; /**< LED widget gradient */
-    QTimer* timer_; /**< Timer */
 };
 
 #endif
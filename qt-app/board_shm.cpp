@@ -0,0 +1,139 @@
+/**
+ * @file board_shm.cpp
+ * @brief Shared board state mapping
+ *
+ * File which maps the board state segment shared with QEMU
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#include "board_shm.h"
+
+/* Includes needed for debugging */
+#include <QDebug>
+
+/* Aditional includes from C library, needed for shared memory */
+#include <errno.h>
+#include <unistd.h>     // Needed for ftruncate
+#include <fcntl.h>      // Defines O_* constants
+#include <sys/stat.h>   // Defines mode constants
+#include <sys/mman.h>   // Defines mmap flags
+
+BoardShm *board_shm_attach(const char *board)
+{
+    /* File descriptor and shared memory object status */
+    int fd;
+    struct stat st;
+    void *addr;
+    /* Shared memory object name of the board */
+    char name[BOARD_SHM_PATH_MAX];
+
+    if (!board_shm_valid_id(board)){
+        qDebug() << "Invalid board ID!\n";
+        return NULL;
+    }
+    board_shm_name(name, sizeof(name), board, "");
+
+    /* Open shared memory object, creating it if QEMU is not running yet.
+     * It is never truncated, so live board state survives reattaching.
+     */
+    fd = shm_open(name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1){
+        qDebug() << "Function shm_open failed!\n";
+        return NULL;
+    }
+
+    /* Set sh. mem. segment size if the segment was just created */
+    if (fstat(fd, &st) == -1 ||
+        (st.st_size < (off_t)sizeof(BoardShm) && ftruncate(fd, sizeof(BoardShm)) == -1)){
+        qDebug() << "Truncating shared memory failed!\n";
+        close(fd);
+        return NULL;
+    }
+
+    /* Map shared memory object to process virtual address space */
+    addr = mmap(NULL, sizeof(BoardShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        qDebug() << "Memory mapping failed!\n";
+        return NULL;
+    }
+
+    /* Refuse segments created with a different layout */
+    if (!board_shm_check_header((BoardShm *)addr)){
+        qDebug() << "Board shared memory layout mismatch!\n";
+        munmap(addr, sizeof(BoardShm));
+        return NULL;
+    }
+
+    return (BoardShm *)addr;
+}
+
+void board_shm_detach(BoardShm *shm)
+{
+    if (shm && munmap(shm, sizeof(BoardShm)) == -1){
+        qDebug() << "Unmapping shared memory failed!\n";
+    }
+}
+
+int board_shm_notify_open(const char *path)
+{
+    if (mkfifo(path, S_IRUSR | S_IWUSR) == -1 && errno != EEXIST){
+        qDebug() << "Creating notification FIFO failed!\n";
+        return -1;
+    }
+
+    /* Opened read-write, so opening never blocks or fails because
+     * QEMU is not running yet, and writes never block
+     */
+    return open(path, O_RDWR | O_NONBLOCK);
+}
+
+void *board_shm_win_attach(const char *board, size_t *size)
+{
+    /* File descriptor and shared memory object status */
+    int fd;
+    struct stat st;
+    void *addr;
+    /* Shared memory object name of the window */
+    char name[BOARD_SHM_PATH_MAX];
+
+    if (!board_shm_valid_id(board)){
+        qDebug() << "Invalid board ID!\n";
+        return NULL;
+    }
+    board_shm_name(name, sizeof(name), board, BOARD_SHM_WIN);
+
+    /* Not created here, its size is set by QEMU */
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd == -1){
+        qDebug() << "Opening shared window failed, is QEMU running?\n";
+        return NULL;
+    }
+
+    if (fstat(fd, &st) == -1 || st.st_size == 0){
+        qDebug() << "Shared window has no size!\n";
+        close(fd);
+        return NULL;
+    }
+
+    addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        qDebug() << "Memory mapping failed!\n";
+        return NULL;
+    }
+
+    *size = st.st_size;
+    return addr;
+}
+
+void board_shm_win_detach(void *win, size_t size)
+{
+    if (win && munmap(win, size) == -1){
+        qDebug() << "Unmapping shared window failed!\n";
+    }
+}
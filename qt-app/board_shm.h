@@ -0,0 +1,414 @@
+/**
+ * @file board_shm.h
+ * @brief Shared board state layout
+ *
+ * Layout of the shared memory segment through which the GUI and the
+ * emulated vexpress board exchange GPIO, I2C and MMS values. The same
+ * layout is declared in qemu/include/hw/misc/board_shm.h (tools/qemu-diff.patch),
+ * both copies must be changed together and BOARD_SHM_VERSION bumped.
+ *
+ * Each block has exactly one writer and is protected by a sequence lock:
+ * the writer makes seq odd, updates the fields and makes seq even again,
+ * readers retry while seq is odd or has changed under them. Blocks are
+ * cache line aligned, so the GUI and QEMU never write the same line.
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#ifndef BOARD_SHM_H
+#define BOARD_SHM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Name of the board state shared memory object. Boards started with a
+ * board ID use "<name>-<ID>" for the segment and all of their FIFOs, so
+ * any number of boards can run on one host.
+ */
+#define BOARD_SHM_NAME          "/vexpress-board"
+
+/** Directory in which shared memory objects appear */
+#define BOARD_SHM_DIR           "/dev/shm"
+
+/** Longest board ID and longest object name or path */
+#define BOARD_SHM_ID_MAX        (32)
+#define BOARD_SHM_PATH_MAX      (128)
+
+/** Header values identifying the layout */
+#define BOARD_SHM_MAGIC         (0x56425344)    /* "VBSD" */
+#define BOARD_SHM_VERSION       (5)
+
+/** Loads of magic an attacher waits for the first attacher's stamp */
+#define BOARD_SHM_STAMP_SPIN    (1000000)
+
+/** Blocks written by different sides never share a cache line */
+#define BOARD_SHM_CACHELINE     (64)
+#define BOARD_SHM_ALIGNED       __attribute__((aligned(BOARD_SHM_CACHELINE)))
+
+/** Segment header, stamped by whoever attaches first */
+typedef struct BoardShmHeader {
+    uint32_t magic;             /**< BOARD_SHM_MAGIC */
+    uint32_t version;           /**< BOARD_SHM_VERSION */
+    uint32_t size;              /**< Size of the whole segment */
+} BOARD_SHM_ALIGNED BoardShmHeader;
+
+/** Single-writer register block */
+typedef struct BoardShmBlock {
+    uint32_t seq;               /**< Sequence lock, odd while being written */
+    uint32_t value;             /**< Register value */
+    uint64_t stamp;             /**< CLOCK_MONOTONIC time of the last write, ns */
+} BOARD_SHM_ALIGNED BoardShmBlock;
+
+/** Number of events a ring can hold, power of two */
+#define BOARD_SHM_RING          (1024)
+
+/** Host input event: a GPIO edge or a queued sensor sample */
+typedef struct BoardShmEvent {
+    uint64_t stamp;             /**< CLOCK_MONOTONIC time of the event, ns */
+    uint32_t value;             /**< Input lines after the edge, or sample */
+    uint32_t mask;              /**< Lines changed by the edge, 0 for samples */
+} BoardShmEvent;
+
+/**
+ * Single-producer/single-consumer ring of host input events. The GUI only
+ * moves head, QEMU only moves tail, so every event is delivered in order.
+ */
+typedef struct BoardShmRing {
+    uint32_t head BOARD_SHM_ALIGNED;    /**< Next slot to fill */
+    uint32_t tail BOARD_SHM_ALIGNED;    /**< Next slot to drain */
+    BoardShmEvent ev[BOARD_SHM_RING] BOARD_SHM_ALIGNED;
+} BoardShmRing;
+
+/**
+ * GPIO lines are addressed by (bank, offset). Each bank is one PL061 with
+ * its own blocks, ring and FIFO, so a bank is updated with a single word
+ * write however many banks the board has.
+ */
+#define BOARD_SHM_GPIO_BANKS    (32)
+#define BOARD_SHM_GPIO_LINES    (8)     /* Lines per bank */
+
+/** Suffix of the FIFOs through which the GUI wakes PL061 banks up, ".gpio<bank>" */
+#define BOARD_SHM_GPIO_NOTIFY   ".gpio"
+
+/** Suffix of the FIFO through which the GUI tells the I2C sensor of samples */
+#define BOARD_SHM_I2C_NOTIFY    ".i2c"
+
+/**
+ * Suffix of the shared window object, mapped as RAM into guest physical
+ * memory by custom.shmwin. QEMU creates it with the size of the window,
+ * host tools map it as it is.
+ */
+#define BOARD_SHM_WIN           ".window"
+
+/** Suffix of the FIFO through which host tools ring the window doorbell */
+#define BOARD_SHM_WIN_NOTIFY    ".window-db"
+
+/** Board state segment */
+typedef struct BoardShm {
+    BoardShmHeader hdr;
+    BoardShmBlock gpio_in[BOARD_SHM_GPIO_BANKS];    /**< GPIO input lines, written by the GUI */
+    BoardShmBlock gpio_out[BOARD_SHM_GPIO_BANKS];   /**< PL061 output lines, written by QEMU on change */
+    BoardShmBlock gpio_gen;     /**< Bumped by QEMU after any gpio_out change */
+    BoardShmRing gpio_ring[BOARD_SHM_GPIO_BANKS];   /**< GPIO input edges, GUI to QEMU */
+    BoardShmBlock i2c;          /**< I2C sensor value, written by the GUI */
+    BoardShmRing i2c_ring;      /**< I2C sensor samples, GUI to QEMU */
+    BoardShmBlock mms;          /**< MM sensor value, written by the GUI */
+    BoardShmBlock win_host;     /**< Window doorbell to the guest, written by host tools */
+    BoardShmBlock win_guest;    /**< Window doorbell from the guest, written by QEMU */
+} BoardShm;
+
+/** Current CLOCK_MONOTONIC time in ns, used for block time stamps */
+static inline uint64_t board_shm_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * Check a board ID. NULL or empty selects the default board, otherwise up
+ * to BOARD_SHM_ID_MAX characters out of [A-Za-z0-9_.-] are allowed.
+ */
+static inline int board_shm_valid_id(const char *board)
+{
+    size_t i;
+
+    if (!board) {
+        return 1;
+    }
+
+    for (i = 0; board[i]; i++) {
+        char c = board[i];
+
+        if (i >= BOARD_SHM_ID_MAX ||
+            !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-')) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/** Build the object name of a board followed by suffix, e.g. for shm_open() */
+static inline void board_shm_name(char *buf, size_t size, const char *board,
+                                  const char *suffix)
+{
+    snprintf(buf, size, "%s%s%s%s", BOARD_SHM_NAME,
+             board && *board ? "-" : "", board ? board : "", suffix);
+}
+
+/** Build the file system path of a board object, e.g. for mkfifo() */
+static inline void board_shm_path(char *buf, size_t size, const char *board,
+                                  const char *suffix)
+{
+    size_t len = strlen(BOARD_SHM_DIR);
+
+    snprintf(buf, size, "%s", BOARD_SHM_DIR);
+    if (len < size) {
+        board_shm_name(buf + len, size - len, board, suffix);
+    }
+}
+
+/** Build the file system path of the notification FIFO of a GPIO bank */
+static inline void board_shm_gpio_notify_path(char *buf, size_t size,
+                                              const char *board,
+                                              unsigned int bank)
+{
+    char suffix[16];
+
+    snprintf(suffix, sizeof(suffix), "%s%u", BOARD_SHM_GPIO_NOTIFY, bank);
+    board_shm_path(buf, size, board, suffix);
+}
+
+/**
+ * Stamp the header of a freshly created segment or check the header of an
+ * existing one. Returns nonzero if the segment has a compatible layout.
+ */
+static inline int board_shm_check_header(BoardShm *shm)
+{
+    uint32_t version = 0;
+    uint32_t magic = 0;
+    long spin;
+
+    if (__atomic_compare_exchange_n(&shm->hdr.version, &version,
+                                    BOARD_SHM_VERSION, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        shm->hdr.size = sizeof(BoardShm);
+        __atomic_store_n(&shm->hdr.magic, BOARD_SHM_MAGIC, __ATOMIC_RELEASE);
+        return 1;
+    }
+
+    if (version != BOARD_SHM_VERSION) {
+        return 0;
+    }
+
+    /* The stamper publishes magic last, it is only a few stores away. A
+     * segment whose magic never shows up was not stamped by this code.
+     */
+    for (spin = 0; spin < BOARD_SHM_STAMP_SPIN && !magic; spin++) {
+        magic = __atomic_load_n(&shm->hdr.magic, __ATOMIC_ACQUIRE);
+    }
+
+    return magic == BOARD_SHM_MAGIC && shm->hdr.size == sizeof(BoardShm);
+}
+
+/** Publish a new value of a block (single writer only) */
+static inline void board_shm_write(BoardShmBlock *b, uint32_t value,
+                                   uint64_t stamp)
+{
+    uint32_t seq = __atomic_load_n(&b->seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&b->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&b->value, value, __ATOMIC_RELAXED);
+    __atomic_store_n(&b->stamp, stamp, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&b->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/** Read a consistent value/stamp pair of a block, stamp may be NULL */
+static inline uint32_t board_shm_read(const BoardShmBlock *b, uint64_t *stamp)
+{
+    uint32_t seq, value;
+    uint64_t t;
+
+    do {
+        seq = __atomic_load_n(&b->seq, __ATOMIC_ACQUIRE);
+        value = __atomic_load_n(&b->value, __ATOMIC_RELAXED);
+        t = __atomic_load_n(&b->stamp, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&b->seq, __ATOMIC_RELAXED));
+
+    if (stamp) {
+        *stamp = t;
+    }
+    return value;
+}
+
+/** Current sequence of a block, to be passed to board_shm_wait() */
+static inline uint32_t board_shm_seq(const BoardShmBlock *b)
+{
+    return __atomic_load_n(&b->seq, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Sleep until the sequence of a block moves away from seq. Returns at once
+ * if it already has, so a write between reading seq and sleeping is never
+ * missed. May also return spuriously.
+ */
+static inline void board_shm_wait(BoardShmBlock *b, uint32_t seq)
+{
+    syscall(SYS_futex, &b->seq, FUTEX_WAIT, seq, NULL, NULL, 0);
+}
+
+/** Wake everybody sleeping in board_shm_wait() on a block */
+static inline void board_shm_wake(BoardShmBlock *b)
+{
+    syscall(SYS_futex, &b->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * Publish a value only if it differs from the current one and wake the
+ * waiters (single writer only). The sequence doubles as a generation
+ * counter, so readers never see redundant writes. Returns nonzero if the
+ * value was written.
+ */
+static inline int board_shm_publish(BoardShmBlock *b, uint32_t value)
+{
+    if (__atomic_load_n(&b->value, __ATOMIC_RELAXED) == value) {
+        return 0;
+    }
+
+    board_shm_write(b, value, board_shm_now());
+    board_shm_wake(b);
+    return 1;
+}
+
+/**
+ * Publish the output lines of a GPIO bank (QEMU only). A real change also
+ * bumps gpio_gen, so one watcher can sleep on all banks at once. Returns
+ * nonzero if the lines changed.
+ */
+static inline int board_shm_publish_gpio(BoardShm *shm, unsigned int bank,
+                                         uint32_t value)
+{
+    if (!board_shm_publish(&shm->gpio_out[bank], value)) {
+        return 0;
+    }
+
+    board_shm_write(&shm->gpio_gen,
+                    __atomic_load_n(&shm->gpio_gen.value, __ATOMIC_RELAXED) + 1,
+                    board_shm_now());
+    board_shm_wake(&shm->gpio_gen);
+    return 1;
+}
+
+/** Queue a host input event (GUI only), returns zero if the ring is full */
+static inline int board_shm_ring_push(BoardShmRing *r, const BoardShmEvent *ev)
+{
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= BOARD_SHM_RING) {
+        return 0;
+    }
+
+    r->ev[head & (BOARD_SHM_RING - 1)] = *ev;
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/** Number of queued host input events */
+static inline uint32_t board_shm_ring_level(BoardShmRing *r)
+{
+    return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+}
+
+/** Take up to max queued host input events (QEMU only), returns the count */
+static inline uint32_t board_shm_ring_pop(BoardShmRing *r, BoardShmEvent *ev,
+                                          uint32_t max)
+{
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    uint32_t n = head - tail;
+    uint32_t i;
+
+    if (n > max) {
+        n = max;
+    }
+
+    for (i = 0; i < n; i++) {
+        ev[i] = r->ev[(tail + i) & (BOARD_SHM_RING - 1)];
+    }
+
+    __atomic_store_n(&r->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+/**
+ * Post a notification. Posts pending at once are merged by the reader,
+ * so a full FIFO is not an error.
+ */
+static inline void board_shm_notify(int fd)
+{
+    char c = 0;
+
+    if (write(fd, &c, 1) < 0) {
+        /* Reader already has wakeups pending */
+    }
+}
+
+/**
+ * Ring the window doorbell of the guest (host only). The value is shown
+ * to the guest driver, fd is the BOARD_SHM_WIN_NOTIFY FIFO.
+ */
+static inline void board_shm_win_ring(BoardShm *shm, int fd, uint32_t value)
+{
+    board_shm_write(&shm->win_host, value, board_shm_now());
+    board_shm_notify(fd);
+}
+
+/**
+ * Map the board state segment of a board, creating it if needed
+ * (board_shm.cpp). Board is a board ID or NULL for the default board.
+ */
+BoardShm *board_shm_attach(const char *board);
+
+/** Unmap a segment returned by board_shm_attach() */
+void board_shm_detach(BoardShm *shm);
+
+/** Open a notification FIFO, creating it if needed, returns -1 on error */
+int board_shm_notify_open(const char *path);
+
+/**
+ * Map the shared window of a board, which QEMU must have created. Stores
+ * the window size in size, returns NULL on error.
+ */
+void *board_shm_win_attach(const char *board, size_t *size);
+
+/** Unmap a window returned by board_shm_win_attach() */
+void board_shm_win_detach(void *win, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file gpiosource.cpp
+ * @brief GPIO source functionalities
+ *
+ * File which defines behavior of GPIO source. Widgets used to map the
+ * board state on their own, so a panel of N LEDs cost N mappings; now
+ * every user goes through one reference counted mapping.
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#include "gpiosource.h"
+
+/* Includes needed for debugging */
+#include <QDebug>
+
+/* Aditional includes from C library, needed for private mapping */
+#include <sys/mman.h>   // Defines mmap flags
+
+QMutex GpioSource::lock_;
+GpioSource::Backend GpioSource::default_ = GpioSource::Shared;
+QByteArray GpioSource::defaultId_;
+GpioSource *GpioSource::instance_ = NULL;
+int GpioSource::refs_ = 0;
+
+void GpioSource::setBackend(Backend backend)
+{
+    QMutexLocker locker(&lock_);
+
+    default_ = backend;
+}
+
+void GpioSource::setBoardId(const QByteArray &board)
+{
+    QMutexLocker locker(&lock_);
+
+    defaultId_ = board;
+}
+
+GpioSource *GpioSource::acquire()
+{
+    QMutexLocker locker(&lock_);
+
+    if (instance_ == NULL){
+        instance_ = new GpioSource(default_, defaultId_);
+    }
+
+    refs_++;
+    return instance_;
+}
+
+void GpioSource::release()
+{
+    QMutexLocker locker(&lock_);
+
+    if (--refs_ == 0){
+        instance_ = NULL;
+        delete this;
+    }
+}
+
+GpioSource::GpioSource(Backend backend, const QByteArray &board) :
+    backend_(backend),
+    boardId_(board),
+    board_(NULL),
+    attached_(false)
+{
+}
+
+GpioSource::~GpioSource()
+{
+    if (board_ == NULL){
+        return;
+    }
+
+    if (backend_ == Shared){
+        board_shm_detach(board_);
+    }
+    else if (munmap(board_, sizeof(BoardShm)) == -1){
+        qDebug() << "Unmapping simulated board state failed!\n";
+    }
+}
+
+GpioSource::Backend GpioSource::backend() const
+{
+    return backend_;
+}
+
+QByteArray GpioSource::boardId() const
+{
+    return boardId_;
+}
+
+BoardShm *GpioSource::board()
+{
+    QMutexLocker locker(&lock_);
+
+    /* Map only once, a failed attempt is not repeated for every widget */
+    if (!attached_){
+        attached_ = true;
+
+        if (backend_ == Shared){
+            board_ = board_shm_attach(boardId_.constData());
+        }
+        else{
+            board_ = simulate();
+        }
+
+        if (board_ == NULL){
+            qDebug() << "Board memory mapping failed!\n";
+        }
+    }
+
+    return board_;
+}
+
+BoardShm *GpioSource::simulate()
+{
+    /* Private zeroed memory with the same layout as the shared segment */
+    void *addr = mmap(NULL, sizeof(BoardShm), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED){
+        return NULL;
+    }
+
+    BoardShm *shm = (BoardShm *)addr;
+    board_shm_check_header(shm);
+
+    /* Show every LED lit in previews */
+    for (int bank = 0; bank < BOARD_SHM_GPIO_BANKS; bank++){
+        board_shm_write(&shm->gpio_out[bank], 0xFFFFFFFF, board_shm_now());
+    }
+
+    return shm;
+}
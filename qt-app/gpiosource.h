@@ -0,0 +1,90 @@
+/**
+ * @file gpiosource.h
+ * @brief GPIO source declarations
+ *
+ * Header file with needed declarations for GPIO source, the backend
+ * which owns the board state mapping of the process
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#ifndef GPIOSOURCE_H
+#define GPIOSOURCE_H
+
+#include <QMutex>
+#include <QByteArray>
+
+/* Shared board state layout */
+#include "board_shm.h"
+
+/**
+ * GPIO source class
+ *
+ * Reference counted singleton shared by the main window, the GPIO watcher
+ * and all LEDs. The board state segment is mapped once per process, on
+ * first use, and unmapped when the last user releases the source.
+ */
+class GpioSource
+{
+public:
+    /** Backend providing the board state */
+    enum Backend {
+        Shared,     /**< Segment shared with QEMU */
+        Simulated   /**< Private memory, used for Designer previews */
+    };
+
+    /** Method selecting the backend, has effect before the first acquire() */
+    static void setBackend(Backend backend);
+
+    /** Method selecting the board ID, has effect before the first acquire() */
+    static void setBoardId(const QByteArray &board);
+
+    /** Method returning the process-wide source and taking a reference */
+    static GpioSource *acquire();
+
+    /** Method dropping a reference taken by acquire() */
+    void release();
+
+    /** Method returning the backend in use */
+    Backend backend() const;
+
+    /** Method returning the board ID in use, empty for the default board */
+    QByteArray boardId() const;
+
+    /** Method returning the board state, mapped on first call, or NULL */
+    BoardShm *board();
+
+private:
+    /**
+     * @brief Constructor
+     *
+     * Constructor only records the backend and board, nothing is mapped yet
+     */
+    GpioSource(Backend backend, const QByteArray &board);
+
+    /**
+     * @brief Destructor
+     *
+     * Destructor unmaps the board state
+     */
+    ~GpioSource();
+
+    /** Mapping private board state for the simulated backend */
+    static BoardShm *simulate();
+
+    static QMutex lock_;            /**< Protects the members below */
+    static Backend default_;        /**< Backend used by the next instance */
+    static QByteArray defaultId_;   /**< Board ID used by the next instance */
+    static GpioSource *instance_;   /**< Process-wide source */
+    static int refs_;               /**< Number of acquire() references */
+
+    Backend backend_;               /**< Backend in use */
+    QByteArray boardId_;            /**< Board ID in use */
+    BoardShm *board_;               /**< Pointer to board state */
+    bool attached_;                 /**< Mapping was already attempted */
+};
+
+#endif // GPIOSOURCE_H
@@ -0,0 +1,95 @@
+/**
+ * @file gpiowatcher.cpp
+ * @brief GPIO watcher functionalities
+ *
+ * File which defines behavior of GPIO watcher. Instead of every LED
+ * polling shared memory on its own timer, one thread sleeps on the GPIO
+ * generation block and wakes only when a PL061 bank publishes new data.
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#include "gpiowatcher.h"
+
+#include <QCoreApplication>
+
+GpioWatcher *GpioWatcher::instance()
+{
+    /* Owned by the application, so the thread is stopped on exit */
+    static GpioWatcher *watcher = new GpioWatcher(QCoreApplication::instance());
+
+    return watcher;
+}
+
+GpioWatcher::GpioWatcher(QObject *parent) :
+    QThread(parent),
+    source_(GpioSource::acquire()),
+    board_(source_->board())
+{
+    if (board_ == NULL) {
+        return;
+    }
+
+    for (int bank = 0; bank < BOARD_SHM_GPIO_BANKS; bank++) {
+        values_[bank].storeRelease(board_shm_read(&board_->gpio_out[bank],
+                                                  NULL));
+    }
+
+    /* Simulated data never changes, nothing to watch */
+    if (source_->backend() == GpioSource::Shared) {
+        start();
+    }
+}
+
+GpioWatcher::~GpioWatcher()
+{
+    /* The thread may be between its check and going to sleep,
+     * so keep waking it until it has finished
+     */
+    requestInterruption();
+    while (isRunning()) {
+        board_shm_wake(&board_->gpio_gen);
+        wait(10);
+    }
+
+    source_->release();
+}
+
+quint32 GpioWatcher::value(int bank) const
+{
+    if (bank < 0 || bank >= BOARD_SHM_GPIO_BANKS) {
+        return 0;
+    }
+
+    return values_[bank].loadAcquire();
+}
+
+void GpioWatcher::run()
+{
+    /* Auxiliary variables */
+    quint32 seq, data, old;
+
+    while (!isInterruptionRequested()) {
+        /* Sequence is sampled before data, so a write in between
+         * makes the wait below return at once
+         */
+        seq = board_shm_seq(&board_->gpio_gen);
+
+        /* Generation does not say which bank changed, banks are only a
+         * word each, so all of them are compared
+         */
+        for (int bank = 0; bank < BOARD_SHM_GPIO_BANKS; bank++) {
+            data = board_shm_read(&board_->gpio_out[bank], NULL);
+
+            old = values_[bank].fetchAndStoreRelaxed(data);
+            if (old != data) {
+                emit changed(bank, old ^ data, data);
+            }
+        }
+
+        board_shm_wait(&board_->gpio_gen, seq);
+    }
+}
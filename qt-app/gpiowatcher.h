@@ -0,0 +1,72 @@
+/**
+ * @file gpiowatcher.h
+ * @brief GPIO watcher declarations
+ *
+ * Header file with needed declarations for GPIO watcher
+ *
+ * @date 2026
+ * @author Dragan Bozinovic (bozinovicdragan96@gmail.com)
+ *
+ * @version [1.0 @ 10/2026] Initial version
+ */
+
+#ifndef GPIOWATCHER_H
+#define GPIOWATCHER_H
+
+#include <QThread>
+#include <QAtomicInteger>
+
+/* Shared board state backend */
+#include "gpiosource.h"
+
+/**
+ * GPIO watcher class
+ *
+ * Single per-process thread which sleeps until any PL061 bank publishes
+ * new GPIO output data and reports which lines of which bank changed
+ */
+class GpioWatcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    /** Method returning the process-wide watcher, started on first use */
+    static GpioWatcher *instance();
+
+    /** Method returning the last published GPIO data of a bank */
+    quint32 value(int bank) const;
+
+signals:
+    /**
+     * @brief GPIO data changed
+     *
+     * Emitted with the bank, the mask of its lines which changed and its
+     * new data
+     */
+    void changed(int bank, quint32 mask, quint32 value);
+
+protected:
+    /**
+     * @brief Constructor
+     *
+     * Constructor takes the GPIO source and starts watching
+     */
+    explicit GpioWatcher(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Destructor stops the thread and releases the GPIO source
+     */
+    ~GpioWatcher();
+
+    /** Thread body, waits for GPIO output changes */
+    void run() override;
+
+private:
+    GpioSource *source_;                /**< Backend owning the mapping */
+    BoardShm *board_;                   /**< Pointer to board state */
+    QAtomicInteger<quint32> values_[BOARD_SHM_GPIO_BANKS]; /**< Last published GPIO data per bank */
+};
+
+#endif // GPIOWATCHER_H
@@ -13,12 +13,28 @@
 /* Default includes */
 #include "mainwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     /* GUI application's control flow */
     QApplication a(argc, argv);
 
+    /* Board ID, must match the board property of the QEMU devices */
+    QCommandLineParser parser;
+    QCommandLineOption boardOption("board", "Attach to board <id>.", "id");
+    parser.addHelpOption();
+    parser.addOption(boardOption);
+    parser.process(a);
+
+    QByteArray board = parser.value(boardOption).toLatin1();
+    if (!board_shm_valid_id(board.constData())){
+        qDebug() << "Invalid board ID!\n";
+        return 1;
+    }
+    GpioSource::setBoardId(board);
+
     /* Show main window */
     MainWindow w;
     w.show();
@@ -50,19 +50,28 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->slider_1, SIGNAL(valueChanged(int)), this, SLOT(i2cValue(int)));
     connect(ui->slider_2, SIGNAL(valueChanged(int)), this, SLOT(mmsValue(int)));
 
-    /* Setting LED gpio pins */
+    /* Setting LED gpio pins, all on the first bank */
     ui->led->setGpioPin(4);
     ui->led_2->setGpioPin(5);
     ui->led_3->setGpioPin(6);
     ui->led_4->setGpioPin(7);
 
     /* Map shared memory segment to appropriate variable */
-    linkGPIOData();
-    linkI2CData();
-    linkMMSData();
+    linkBoardData();
 
-    /* Initialize named semaphore */
-    initializeSemaphore();
+    /* Tell windows of different boards apart */
+    if (!source->boardId().isEmpty()){
+        this->setWindowTitle("User interface - " + QString(source->boardId()));
+    }
+
+    /* Open GPIO notification FIFO of the first bank and I2C notification
+     * FIFO, FIFOs of further banks are opened once they are used
+     */
+    for (int bank = 0; bank < BOARD_SHM_GPIO_BANKS; bank++){
+        gpioNotify[bank] = -1;
+    }
+    openGPIONotify(0);
+    openI2CNotify();
 
 }
 
@@ -71,109 +80,61 @@ MainWindow::~MainWindow()
     /* Delete parent widget */
     delete ui;
 
-    /* Unlink shared memory */
-    if (shm_unlink("gpio") == -1){
-        qDebug() << "Unlinking sh. mem. file descriptor failed!\n";
-    }
-
-    if (shm_unlink("i2c") == -1){
-        qDebug() << "Unlinking sh. mem. file descriptor failed!\n";
-    }
+    /* Release shared memory. The segment and the FIFOs are not unlinked,
+     * a board which keeps running still uses them and a GUI started
+     * again has to find the same objects.
+     */
+    source->release();
 
-    if (shm_unlink("mmsens") == -1){
-        qDebug() << "Unlinking sh. mem. file descriptor failed!\n";
-    }
+    /* Close GPIO notification FIFOs which were opened */
+    for (int bank = 0; bank < BOARD_SHM_GPIO_BANKS; bank++){
+        if (gpioNotify[bank] == -1){
+            continue;
+        }
 
-    /* Close semaphore */
-    if (sem_close(sem) == -1){
-        qDebug() << "Closing named semaphore failed!\n";
+        if (close(gpioNotify[bank]) == -1){
+            qDebug() << "Closing GPIO notification FIFO failed!\n";
+        }
     }
 
-    /* Unlink semapore */
-    if (sem_unlink("/gpio") == -1){
-        qDebug() << "Unlinking named semaphore failed!\n";
+    /* Close I2C notification FIFO */
+    if (i2cNotify != -1 && close(i2cNotify) == -1){
+        qDebug() << "Closing I2C notification FIFO failed!\n";
     }
 
 
 }
 
-void MainWindow::linkGPIOData()
+void MainWindow::linkBoardData()
 {
-    /* File descriptor and auxiliary variable for storing size of shared memory */
-    int fd, segSize;
-    segSize = sizeof(quint32);
-
-    /* Create new shared memory object */
-    fd = shm_open("gpio", O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
-    if (fd == -1){
-        qDebug() << "Function shm_open failed!\n";
-    }
-
-    /* Set sh. mem. segment size */
-    if (ftruncate(fd, segSize) == -1){
-        qDebug() << "Truncating shared memory failed!\n";
-    }
-
-    /* Map shared memory object to process virtual address space */
-    data_gpio = (unsigned int*)mmap(NULL, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data_gpio == MAP_FAILED) {
-        qDebug() << "Memory mapping failed!\n";
-    }
+    /* Board state segment shared with QEMU, mapped once per process */
+    source = GpioSource::acquire();
+    board = source->board();
 }
 
-void MainWindow::linkI2CData()
+int MainWindow::openGPIONotify(int bank)
 {
-    /* File descriptor and auxiliary variable for storing size of shared memory */
-    int fd, segSize;
-    segSize = sizeof(quint32);
-
-    /* Create new shared memory object */
-    fd = shm_open("i2c", O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
-    if (fd == -1){
-        qDebug() << "Function shm_open failed!\n";
-    }
-
-    /* Set sh. mem. segment size */
-    if (ftruncate(fd, segSize) == -1){
-        qDebug() << "Truncating shared memory failed!\n";
-    }
-
-    /* Map shared memory object to process virtual address space */
-    data_i2c = (unsigned int*)mmap(NULL, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data_i2c == MAP_FAILED) {
-        qDebug() << "I2C memory mapping failed!\n";
-    }
-}
-
-void MainWindow::linkMMSData()
-{
-    /* File descriptor and auxiliary variable for storing size of shared memory */
-    int fd, segSize;
-    segSize = sizeof(quint32);
-
-    /* Create new shared memory object */
-    fd = shm_open("mmsens", O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
-    if (fd == -1){
-        qDebug() << "Function shm_open failed!\n";
+    if (gpioNotify[bank] != -1){
+        return gpioNotify[bank];
     }
 
-    /* Set sh. mem. segment size */
-    if (ftruncate(fd, segSize) == -1){
-        qDebug() << "Truncating shared memory failed!\n";
+    board_shm_gpio_notify_path(gpioNotifyPath[bank], sizeof(gpioNotifyPath[bank]),
+                               source->boardId().constData(), bank);
+    gpioNotify[bank] = board_shm_notify_open(gpioNotifyPath[bank]);
+    if (gpioNotify[bank] == -1){
+        qDebug() << "Opening GPIO notification FIFO failed!\n";
     }
 
-    /* Map shared memory object to process virtual address space */
-    data_mms = (unsigned int*)mmap(NULL, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data_mms == MAP_FAILED) {
-        qDebug() << "MM sens memory mapping failed!\n";
-    }
+    return gpioNotify[bank];
 }
 
-void MainWindow::initializeSemaphore()
+void MainWindow::openI2CNotify()
 {
-    sem = sem_open("/gpio", O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, 0);
-    if (sem == SEM_FAILED){
-        qDebug() << "Creating named semaphore failed!\n";
+    board_shm_path(i2cNotifyPath, sizeof(i2cNotifyPath),
+                   source->boardId().constData(), BOARD_SHM_I2C_NOTIFY);
+    i2cNotify = board_shm_notify_open(i2cNotifyPath);
+    if (i2cNotify == -1){
+        qDebug() << "Opening I2C notification FIFO failed!\n";
     }
 
 }
@@ -182,40 +143,71 @@ void MainWindow::pinValue()
 {
     /* Determine which button was clicked */
     QObject* button = QObject::sender();
-    /* Auxiliary variables needed for changing GPIO pin value */
-    unsigned int mask, bit;
 
-    /* Determine mask value */
+    /* Buttons drive lines 0 - 3 of the first bank */
     if (button == ui->pushButton)
     {
-        mask = 1 << 0;
+        setInput(0, 0);
     }
     else if (button == ui->pushButton_2)
     {
-        mask = 1 << 1;
+        setInput(0, 1);
     }
     else if (button == ui->pushButton_3)
     {
-        mask = 1 << 2;
+        setInput(0, 2);
     }
     else
     {
-        mask = 1 << 3;
+        setInput(0, 3);
+    }
+}
+
+void MainWindow::setInput(int bank, int offset)
+{
+    /* Auxiliary variables needed for changing GPIO pin value */
+    unsigned int mask, bit, data;
+    /* Edge event passed to PL061 */
+    BoardShmEvent ev;
+    /* Notification FIFO of the bank */
+    int fd;
+
+    if (board == NULL || bank < 0 || bank >= BOARD_SHM_GPIO_BANKS ||
+        offset < 0 || offset >= BOARD_SHM_GPIO_LINES){
+        return;
     }
 
+    /* Determine mask value */
+    mask = 1u << offset;
+
     /* Get data bit value and toggle it */
-    bit = *data_gpio & mask;
+    data = board_shm_read(&board->gpio_in[bank], NULL);
+    bit = data & mask;
 
     if (bit){
-        *data_gpio -= mask;
+        data -= mask;
     }
     else{
-        *data_gpio += mask;
+        data += mask;
     }
 
-    /* Increment semaphore value */
-    if (sem_post(sem) == -1){
-        qDebug() << "Failed to increment named sem. value!\n";
+    /* Queue the edge, so PL061 sees it even if it toggles back before
+     * QEMU gets to run
+     */
+    ev.stamp = board_shm_now();
+    ev.value = data;
+    ev.mask = mask;
+    if (!board_shm_ring_push(&board->gpio_ring[bank], &ev)){
+        qDebug() << "GPIO event ring full, edge not sent!\n";
+        return;
+    }
+
+    board_shm_write(&board->gpio_in[bank], data, ev.stamp);
+
+    /* Wake PL061 up, pending wakeups are merged by QEMU */
+    fd = openGPIONotify(bank);
+    if (fd != -1){
+        board_shm_notify(fd);
     }
 
 }
@@ -223,14 +215,38 @@ void MainWindow::pinValue()
 void MainWindow::i2cValue(int val){
     /* String which will be printed if debugging */
     QString outString;
+    /* Sample queued for the sensor */
+    BoardShmEvent ev;
+
+    if (board == NULL){
+        return;
+    }
+
+    ev.stamp = board_shm_now();
+    ev.value = val;
+    ev.mask = 0;
 
-    *data_i2c = val;
+    /* Queue every sample, the sensor hands several out per transfer */
+    if (!board_shm_ring_push(&board->i2c_ring, &ev)){
+        qDebug() << "I2C sample ring full, sample not queued!\n";
+    }
+
+    board_shm_write(&board->i2c, val, ev.stamp);
+
+    /* Let the sensor raise its data-ready line */
+    if (i2cNotify != -1){
+        board_shm_notify(i2cNotify);
+    }
 }
 
 void MainWindow::mmsValue(int val){
     /* String which will be printed if debugging */
     QString outString;
 
-    *data_mms = val;
+    if (board == NULL){
+        return;
+    }
+
+    board_shm_write(&board->mms, val, board_shm_now());
 }
 
@@ -14,7 +14,9 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <semaphore.h>
+
+/* Shared board state backend */
+#include "gpiosource.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -39,7 +41,7 @@ public:
     /**
      * @brief Destructor
      *
-     * Destructor unlinks shared memory
+     * Destructor releases shared memory, which stays linked for the board
      */
     ~MainWindow();
 
@@ -58,39 +60,43 @@ private slots:
 
 protected:
     /**
-     * @brief GPIO shared memory mapping
+     * @brief Board shared memory mapping
      *
-     * Mapping GPIO shared memory data to private data
+     * Taking the board state (GPIO, I2C and MMS blocks) from the
+     * mapping shared by the whole process
      */
-    void linkGPIOData();
+    void linkBoardData();
 
     /**
-     * @brief I2C shared memory mapping
+     * @brief GPIO notification initialization
      *
-     * Mapping I2C shared memory data to private data
+     * Opening FIFO through which PL061 of a bank is notified about GPIO
+     * input events, on first use of the bank. Returns the descriptor or -1.
      */
-    void linkI2CData();
+    int openGPIONotify(int bank);
 
     /**
-     * @brief MMS shared memory mapping
+     * @brief Toggling a GPIO input line
      *
-     * Mapping MMS shared memory data to private data
+     * Flipping line offset of a bank and passing the edge to its PL061
      */
-    void linkMMSData();
+    void setInput(int bank, int offset);
 
     /**
-     * @brief GPIO semaphore initialization
+     * @brief I2C notification initialization
      *
-     * Initialization of named semapore needed for GPIO synchronization
+     * Opening FIFO through which I2C sensor is notified about queued samples
      */
-    void initializeSemaphore();
+    void openI2CNotify();
 
 private:
     Ui::MainWindow *ui;         /**< Pointer to parent widget */
-    unsigned int *data_gpio;    /**< Pointer to shared memory containing GPIO data */
-    unsigned int *data_i2c;     /**< Pointer to shared memory containing I2C data */
-    unsigned int *data_mms;     /**< Pointer to shared memory containing MMS data */
-    sem_t *sem;                 /**< Pointer to named semaphore */
+    GpioSource *source;         /**< Backend owning the board state mapping */
+    BoardShm *board;            /**< Pointer to shared memory containing board state */
+    int gpioNotify[BOARD_SHM_GPIO_BANKS];   /**< GPIO notification FIFO descriptors, per bank */
+    char gpioNotifyPath[BOARD_SHM_GPIO_BANKS][BOARD_SHM_PATH_MAX]; /**< GPIO notification FIFO paths */
+    int i2cNotify;              /**< I2C notification FIFO descriptor */
+    char i2cNotifyPath[BOARD_SHM_PATH_MAX];  /**< I2C notification FIFO path */
 
 };
 #endif // MAINWINDOW_H
@@ -13,11 +13,17 @@ LIBS += -lrt
 
 SOURCES += \
     LED.cpp \
+    board_shm.cpp \
+    gpiosource.cpp \
+    gpiowatcher.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
     LED.h \
+    board_shm.h \
+    gpiosource.h \
+    gpiowatcher.h \
     mainwindow.h
 
 FORMS += \
@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>      // For error handling
+#include <limits.h>     // Defines PATH_MAX
 #include <unistd.h>     // Needed for ftruncate
 #include <fcntl.h>      // Defines O_* constants
 #include <sys/stat.h>   // Defines mode constants
@@ -27,6 +28,7 @@
 #include <time.h>       // Needed for sleep function
 #include <signal.h>     // Needed for signal handling
 #include <pthread.h>    // Needed for multi-threading
+#include <dirent.h>     // Needed for finding GPIO chips
 
 /** Includes needed for periodicity */
 #include <sys/time.h>
@@ -36,12 +38,18 @@
 #include <sys/epoll.h>
 /** Includes needed for proper I2C functionality */
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
+/** Name of the sensor bus adapter, i2c-dev numbering depends on probe order */
+#define I2C_BUS_NAME "custom_i2cctl"
+
 /** I2C parameters - address, registers and mask */
 #define CUSTOM_I2C_SENS_ADDR (27)
 #define I2C_CTRL_OFFSET                 (0x0)
 #define I2C_DATA_OFFSET                 (0x1)
+#define I2C_COUNT_OFFSET                (0x2)
+#define I2C_NUM_SAMPLES                 (8)
 #define I2C_CTRL_EN_SHIFT               (1)
 #define I2C_CTRL_EN_MASK                (0x01)
 
@@ -51,10 +59,25 @@
 /** Macro for GPIO polling */
 #define POLLGPIO (POLLPRI | POLLERR)
 
+/**
+ * Host GPIO bank the application uses. Bank 0 is the motherboard PL061,
+ * further banks (QEMU -global pl061.banks=N) follow at 0x10040000, one
+ * 4K page each. Chip bases depend on probe order, so chips are found by label.
+ */
+#define GPIO_BANK (0)
+#define GPIO_BANK0_ADDR (0x10003000)
+#define GPIO_BANKS_ADDR (0x10040000)
+#define GPIO_BANK_ADDR(bank) ((bank) ? GPIO_BANKS_ADDR + ((bank) - 1) * 0x1000 \
+                                     : GPIO_BANK0_ADDR)
+/** Label of second PL061 GPIO controller, holding I2C sensor data-ready line */
+#define GPIO_DRDY_LABEL "1000e000.pl061"
+
 /** Base GPIO number, corresponding to first pin of PL061 GPIO controller*/
 unsigned int pin_base = 2027;
 /** Number of GPIO pins which will be used */
 unsigned int pin_num = 8;
+/** GPIO number of I2C sensor data-ready line, first pin of second PL061 GPIO controller */
+unsigned int drdy_pin = 2019;
 /** Buffer which holds strings needed for different operations */
 char buf[MAX_BUF];
 
@@ -150,29 +173,206 @@ static void wait_period(struct periodic_info *info) {
 	info->wakeups_missed += missed;
 }
 
+/**
+ * @brief Read I2C samples
+ *
+ * Function reads sample count and all queued samples in one transaction and
+ * prints them, repeating while the sensor buffer comes back full.
+ *
+ */
+static void i2c_read_samples(int fd){
+	/* Buffer used for communication, count and 16-bit samples */
+    unsigned char buffer[1 + 2 * I2C_NUM_SAMPLES];
+	/* Aux. variables for storing data */
+	uint16_t data;
+	int count, i;
+
+	/* Register address write and read with a repeated start */
+	unsigned char reg = I2C_COUNT_OFFSET;
+	struct i2c_msg msgs[2] = {
+		{ .addr = CUSTOM_I2C_SENS_ADDR, .flags = 0, .len = 1, .buf = &reg },
+		{ .addr = CUSTOM_I2C_SENS_ADDR, .flags = I2C_M_RD, .len = sizeof(buffer), .buf = buffer },
+	};
+	struct i2c_rdwr_ioctl_data rdwr = { .msgs = msgs, .nmsgs = 2 };
+
+	do {
+		if (ioctl(fd, I2C_RDWR, &rdwr) < 0) {
+			printf("I2C transfer failed\n");
+			return;
+		}
+		
+		/* Nothing queued, first sample holds the current value */
+		count = buffer[0] ? buffer[0] : 1;
+		
+		for (i = 0; i < count; i++) {
+			/* Samples are big endian */
+			data = (buffer[1 + 2 * i] << 8) | buffer[2 + 2 * i];
+			
+			printf("I2C_data = %d\n", data);
+		}
+	} while (buffer[0] == I2C_NUM_SAMPLES);
+}
+
+/**
+ * @brief Open I2C bus
+ *
+ * Function opens the i2c-dev node of the adapter with given name.
+ * Returns file descriptor, or -1 if there is no such adapter.
+ *
+ */
+static int i2c_bus_open(const char *name){
+    DIR *dir;
+    struct dirent *ent;
+    char path[PATH_MAX], adapter[MAX_BUF];
+    FILE *f;
+    int fd = -1;
+
+    dir = opendir("/sys/class/i2c-dev");
+    if (dir == NULL) {
+        return -1;
+    }
+
+    while (fd < 0 && (ent = readdir(dir)) != NULL) {
+        if (strncmp(ent->d_name, "i2c-", 4) != 0) {
+            continue;
+        }
+
+        /* Compare adapter name, without trailing new line */
+        snprintf(path, sizeof(path), "/sys/class/i2c-dev/%s/name", ent->d_name);
+        f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        if (fgets(adapter, sizeof(adapter), f) == NULL) {
+            adapter[0] = '\0';
+        }
+        fclose(f);
+        adapter[strcspn(adapter, "\n")] = '\0';
+        if (strcmp(adapter, name) != 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/dev/%s", ent->d_name);
+        fd = open(path, O_RDWR);
+    }
+
+    closedir(dir);
+    return fd;
+}
+
+/**
+ * @brief Find GPIO chip base
+ *
+ * Function looks up the GPIO chip with given label and stores the number
+ * of its first pin in base. Returns 0 on success, -1 if there is no such chip.
+ *
+ */
+static int gpio_chip_base(const char *label, unsigned int *base){
+    DIR *dir;
+    struct dirent *ent;
+    char path[PATH_MAX], name[MAX_BUF];
+    FILE *f;
+    int ret = -1;
+
+    dir = opendir("/sys/class/gpio");
+    if (dir == NULL) {
+        return -1;
+    }
+
+    while (ret != 0 && (ent = readdir(dir)) != NULL) {
+        if (strncmp(ent->d_name, "gpiochip", 8) != 0) {
+            continue;
+        }
+
+        /* Compare label, without trailing new line */
+        snprintf(path, sizeof(path), "/sys/class/gpio/%s/label", ent->d_name);
+        f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        if (fgets(name, sizeof(name), f) == NULL) {
+            name[0] = '\0';
+        }
+        fclose(f);
+        name[strcspn(name, "\n")] = '\0';
+        if (strcmp(name, label) != 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/sys/class/gpio/%s/base", ent->d_name);
+        f = fopen(path, "r");
+        if (f == NULL) {
+            continue;
+        }
+        if (fscanf(f, "%u", base) == 1) {
+            ret = 0;
+        }
+        fclose(f);
+    }
+
+    closedir(dir);
+    return ret;
+}
+
+/**
+ * @brief Open I2C data-ready pin
+ *
+ * Function exports data-ready pin and sets it up for rising edge interrupts.
+ * Returns value file descriptor, or -1 if the pin is not available.
+ *
+ */
+static int i2c_open_drdy(){
+    /* File descriptor and length of string written in buffer */
+    int fd, len;
+    char path[MAX_BUF];
+
+    /* Keep the default pin if the chip is not found */
+    gpio_chip_base(GPIO_DRDY_LABEL, &drdy_pin);
+
+    fd = open("/sys/class/gpio/export", O_WRONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    len = snprintf(path, sizeof(path), "%d", drdy_pin);
+    write(fd, path, len);
+    close(fd);
+
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/edge", drdy_pin);
+    fd = open(path, O_WRONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    write(fd, "rising", 7);
+    close(fd);
+
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", drdy_pin);
+    return open(path, O_RDONLY);
+}
+
 /**
  * @brief I2C thread
  *
  * Function which represents I2C thread. It consists of opening, enabling and reading data
- * from I2C slave, after which result is constantly printed to display.
+ * from I2C slave whenever its data-ready pin rises, after which result is printed to display.
+ * Without the data-ready pin the slave is polled every second.
  *
  */
 void *i2c_handler(){
     /* Periodicity structure */
-    struct periodic_info info;
+    struct periodic_info info = { 0 };
 	/* I2C file descriptor */
     int fd;
 	/* Buffer used for communication */
     char buffer[4];
-	/* Aux. variables for storing data */
-	uint8_t data;
+	/* Data-ready pin poll structure */
+	struct pollfd pfd;
     
     printf("I2C thread started\n");
 	
 	/* Open I2C and set slave address */
-	fd = open("/dev/i2c-2",O_RDWR);
+	fd = i2c_bus_open(I2C_BUS_NAME);
 	if (fd < 0){
-		printf("Can't open i2c-2\n");
+		printf("Can't open I2C bus %s\n", I2C_BUS_NAME);
 	}
 	if (ioctl(fd, I2C_SLAVE, CUSTOM_I2C_SENS_ADDR) < 0) { 
 		printf("Can't set I2C slave address\n");
@@ -183,22 +383,28 @@ void *i2c_handler(){
     buffer[1] = I2C_CTRL_EN_MASK;
     write(fd, buffer, 2) ;
 	
-	/* Enable timer */
-	make_periodic(1000000, &info);
+	/* Wait on data-ready pin, fall back to timer without it */
+	pfd.fd = i2c_open_drdy();
+	pfd.events = POLLGPIO;
+	if (pfd.fd < 0){
+		printf("No I2C data-ready pin, polling\n");
+		make_periodic(1000000, &info);
+	}
 
     while (1) {
-	    /* Wait for timer event */
-		wait_period(&info);
+		/* Read whatever is queued, also before the first wait */
+		i2c_read_samples(fd);
 		
-		/* Read from data register */
-		buffer[0] = I2C_DATA_OFFSET;
-		write(fd,buffer,1);
-		read(fd,buffer,1);
-		
-		/* Store in aux. var */
-		data = (int8_t)buffer[0];
-		
-		printf("I2C_data = %d\n", data);
+		if (pfd.fd >= 0){
+			/* Block until new samples raise data-ready */
+			poll(&pfd, 1, -1);
+			lseek(pfd.fd, 0, SEEK_SET);
+			read(pfd.fd, buffer, sizeof(buffer));
+		}
+		else{
+		    /* Wait for timer event */
+			wait_period(&info);
+		}
     }
 	
 	close(fd);
@@ -304,6 +510,14 @@ int main(){
     pthread_t i2c_thread, mms_thread;
     /* Poll structure needed for GPIO pin interrupts*/
     struct pollfd pfds[4];
+    /* Label of the GPIO bank chip */
+    char label[MAX_BUF];
+    
+    /* Find first pin of the GPIO bank, keep the default if not found */
+    snprintf(label, sizeof(label), "%x.pl061", GPIO_BANK_ADDR(GPIO_BANK));
+    if (gpio_chip_base(label, &pin_base) < 0) {
+        printf("GPIO chip %s not found, using base %u\n", label, pin_base);
+    }
     
     /* Prepare for Ctrl+C signal handling */
     signal(SIGINT, sig_handler);
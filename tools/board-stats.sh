@@ -0,0 +1,88 @@
+#!/bin/bash
+
+# run in subshell
+(
+
+# error handling
+set -e
+
+err_report() {
+    echo "---------------------------------------------------------------------"
+    echo "                            FAILED!"
+    echo "Script failed while executing"
+    echo ""
+    echo "line $1 : ${@:2}."
+    echo ""
+    echo "---------------------------------------------------------------------"
+}
+
+trap 'err_report $LINENO $BASH_COMMAND' ERR
+
+# QMP socket of a running board, QEMU started with
+# -qmp unix:qmp.sock,server,nowait
+QMP=${1:-${QMP:-"qmp.sock"}}
+# device types which keep statistics
+TYPES="pl061|custom.i2csens|custom.i2cctl|custom.mmsens|custom.shmwin"
+
+# send QMP commands given as arguments, one reply per line
+qmp() {
+    {
+        echo '{"execute": "qmp_capabilities"}'
+        for cmd in "$@"; do
+            echo "${cmd}"
+        done
+    } | socat -t 5 - UNIX-CONNECT:${QMP} | grep '"return"' | tail -n +2
+}
+
+# find the devices in the QOM tree, one "path type" per line
+DEVICES=$(qmp '{"execute": "human-monitor-command",
+                "arguments": {"command-line": "info qom-tree"}}' |
+    sed -e 's/^{"return": "//' -e 's/"}$//' -e 's/\\r\\n/\n/g' |
+    awk -v types="^(${TYPES})$" '
+        /^ *\// {
+            match($0, /^ */)
+            depth = RLENGTH / 2
+            name[depth] = $1
+            type = $2
+            gsub(/[()]/, "", type)
+            if (type ~ types) {
+                path = ""
+                for (i = 0; i <= depth; i++) {
+                    path = path name[i]
+                }
+                print path, type
+            }
+        }')
+
+if [ -z "${DEVICES}" ]; then
+    echo "No custom devices found through ${QMP}"
+    false
+fi
+
+# print statistics of every device
+echo "${DEVICES}" | while read path type; do
+    echo "-------------------------------------------------------------------------"
+    echo " ${type} ${path}"
+    echo "-------------------------------------------------------------------------"
+    qmp "{\"execute\": \"qom-get\",
+          \"arguments\": {\"path\": \"${path}\", \"property\": \"stats\"}}" |
+        sed -e 's/^{"return": {//' -e 's/}}$//' -e 's/, "/\n"/g' -e 's/"//g' |
+        awk -F ': ' '
+            $1 == "latency-us" {
+                gsub(/[][]/, "", $2)
+                n = split($2, b, ", ")
+                print "latency (us):"
+                for (i = 1; i <= n; i++) {
+                    if (b[i] == 0) {
+                        continue
+                    }
+                    lo = i == 1 ? 0 : 2 ^ (i - 2)
+                    hi = i == n ? "inf" : 2 ^ (i - 1)
+                    printf "    [%s, %s) %s\n", lo, hi, b[i]
+                }
+                next
+            }
+            { printf "%s: %s\n", $1, $2 }'
+done
+
+)
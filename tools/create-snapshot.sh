@@ -0,0 +1,113 @@
+#!/bin/bash
+
+# run in subshell
+(
+
+# error handling
+set -e
+
+err_report() {
+    echo "---------------------------------------------------------------------"
+    echo "                            FAILED!"
+    echo "Script failed while executing"
+    echo ""
+    echo "line $1 : ${@:2}."
+    echo ""
+    echo "---------------------------------------------------------------------"
+}
+
+trap 'err_report $LINENO $BASH_COMMAND' ERR
+
+# board is booted once from SD card image, snapshot is kept in a qcow2
+# overlay, so the image itself is never changed
+SDIMG_NAME=${SDIMG_NAME:-"sd.img"}
+SNAP_IMG=${SNAP_IMG:-"sd-warm.qcow2"}
+SNAP_NAME=${SNAP_NAME:-"app-ready"}
+APP=${APP:-"/home/chardev_app"}
+UBOOT=${UBOOT:-"../u-boot/u-boot"}
+QEMU=${QEMU:-"qemu-system-arm"}
+# extra options, e.g. -global pl061.board=b1
+QEMU_EXTRA=${QEMU_EXTRA:-""}
+BOOT_TIMEOUT=${BOOT_TIMEOUT:-300}
+
+WORK=$(mktemp -d)
+SERIAL=${WORK}/serial
+MONITOR=${WORK}/monitor.sock
+LOG=${WORK}/serial.log
+
+cleanup() {
+    kill ${CAT_PID} ${QEMU_PID} 2> /dev/null || true
+    rm -rf ${WORK}
+}
+trap cleanup EXIT
+
+# wait until serial console printed given text
+wait_for() {
+    local t=0
+    until grep -q "$1" ${LOG}; do
+        sleep 1
+        t=$((t + 1))
+        if [ $t -ge ${BOOT_TIMEOUT} ]; then
+            echo "Timeout waiting for '$1', console log:"
+            cat ${LOG}
+            false
+        fi
+    done
+}
+
+# create overlay
+echo "-------------------------------------------------------------------------"
+echo " Creating snapshot image ${SNAP_IMG} ..."
+echo "-------------------------------------------------------------------------"
+qemu-img create -f qcow2 -F raw -b ${SDIMG_NAME} ${SNAP_IMG}
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+# boot board, console goes through a pipe pair so it can be scripted
+echo "-------------------------------------------------------------------------"
+echo " Booting board ..."
+echo "-------------------------------------------------------------------------"
+mkfifo ${SERIAL}.in ${SERIAL}.out
+touch ${LOG}
+cat ${SERIAL}.out > ${LOG} &
+CAT_PID=$!
+${QEMU} -M vexpress-a9 -m 512M -kernel ${UBOOT} \
+    -drive file=${SNAP_IMG},format=qcow2,if=sd \
+    -serial pipe:${SERIAL} -monitor unix:${MONITOR},server,nowait \
+    -display none ${QEMU_EXTRA} &
+QEMU_PID=$!
+wait_for "login:"
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+# log in and start application
+echo "-------------------------------------------------------------------------"
+echo " Starting ${APP} ..."
+echo "-------------------------------------------------------------------------"
+echo "root" > ${SERIAL}.in
+wait_for "# "
+echo "${APP} &" > ${SERIAL}.in
+wait_for "I2C thread started"
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+# save snapshot and stop board
+echo "-------------------------------------------------------------------------"
+echo " Saving snapshot ${SNAP_NAME} ..."
+echo "-------------------------------------------------------------------------"
+printf "savevm ${SNAP_NAME}\nquit\n" | socat -t 60 - UNIX-CONNECT:${MONITOR} > /dev/null
+wait ${QEMU_PID}
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+echo "-------------------------------------------------------------------------"
+echo "             Finished creating snapshot ${SNAP_NAME}!"
+echo " Start from it with: ${QEMU} -M vexpress-a9 -m 512M -kernel ${UBOOT}"
+echo "     -drive file=${SNAP_IMG},format=qcow2,if=sd -loadvm ${SNAP_NAME}"
+echo "-------------------------------------------------------------------------"
+
+)
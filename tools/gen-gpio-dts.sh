@@ -0,0 +1,103 @@
+#!/bin/bash
+
+# run in subshell
+(
+
+# error handling
+set -e
+
+err_report() {
+    echo "---------------------------------------------------------------------"
+    echo "                            FAILED!"
+    echo "Script failed while executing"
+    echo ""
+    echo "line $1 : ${@:2}."
+    echo ""
+    echo "---------------------------------------------------------------------"
+}
+
+trap 'err_report $LINENO $BASH_COMMAND' ERR
+
+# number of host GPIO banks, must match -global pl061.banks given to QEMU
+BANKS=${1:-1}
+LINUX=${LINUX:-"../linux"}
+DTS=arch/arm/boot/dts/vexpress-v2p-ca9-gpio.dts
+# DTB loaded by boot.scr
+DTB=arch/arm/boot/dts/vexpress-v2p-ca9.dtb
+
+# banks 1 and up, same address and IRQ numbers as vexpress.c
+BANK_BASE=0x10040000
+IRQS=(17 18 19 20 21 22 23 24 25 30 31 32 33 34 35 36 37 38 39 \
+      45 46 47 49 50 51 52 53 54 55 56 57)
+
+if [ ${BANKS} -lt 1 ] || [ ${BANKS} -gt $((${#IRQS[@]} + 1)) ]; then
+    echo "Number of banks must be between 1 and $((${#IRQS[@]} + 1))"
+    false
+fi
+
+# generate device tree, banks sit outside of the motherboard window,
+# so they are described on their own bus and wired straight to the GIC
+echo "-------------------------------------------------------------------------"
+echo " Generating ${DTS} for ${BANKS} GPIO banks ..."
+echo "-------------------------------------------------------------------------"
+{
+cat << EOF
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Generated by tools/gen-gpio-dts.sh for ${BANKS} host GPIO banks.
+ * Bank 0 is gpio0 of vexpress-v2m.dtsi, lines of further banks are
+ * named BANK<bank>_<offset>.
+ */
+#include "vexpress-v2p-ca9.dts"
+
+/ {
+	gpio-banks {
+		compatible = "simple-bus";
+		#address-cells = <1>;
+		#size-cells = <1>;
+		ranges;
+		interrupt-parent = <&gic>;
+EOF
+for ((bank = 1; bank < BANKS; bank++)); do
+    addr=$(printf "%x" $((BANK_BASE + (bank - 1) * 0x1000)))
+    names=""
+    for ((line = 0; line < 8; line++)); do
+        names="${names}${names:+, }\"BANK${bank}_${line}\""
+    done
+cat << EOF
+
+		gpio_bank${bank}: pl061@${addr} {
+			compatible = "arm,pl061", "arm,primecell";
+			reg = <0x${addr} 0x1000>;
+			interrupts = <0 ${IRQS[$((bank - 1))]} 4>;
+			gpio-controller;
+			#gpio-cells = <2>;
+			gpio-line-names = ${names};
+			interrupt-controller;
+			#interrupt-cells = <2>;
+			clocks = <&smbclk>;
+			clock-names = "apb_pclk";
+		};
+EOF
+done
+cat << EOF
+	};
+};
+EOF
+} > ${LINUX}/${DTS}
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+# compile it in place of the plain board DTB, the one app-to-sd.sh copies
+echo "-------------------------------------------------------------------------"
+echo " Compiling ${DTB} ..."
+echo "-------------------------------------------------------------------------"
+cd ${LINUX}
+cpp -nostdinc -I include -I arch/arm/boot/dts -undef -D__DTS__ \
+    -x assembler-with-cpp ${DTS} | scripts/dtc/dtc -I dts -O dtb -o ${DTB} -
+echo "-------------------------------------------------------------------------"
+echo "                        ... done!"
+echo "-------------------------------------------------------------------------"
+
+)